@@ -4,6 +4,21 @@
 #include <time.h>
 #include <math.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/time.h>
 
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
@@ -15,9 +30,28 @@ char *result_string; // text to print along with result from algorithm
 char *x, *y; // the two strings that the algorithm will execute on
 char *filename; // file containing the two strings
 int xLen, yLen, alphabetSize; // lengths of two strings and size of alphabet
-bool iterBool = false, recNoMemoBool = false, recMemoBool = false; // which type of dynamic programming to run
+bool iterBool = false, recNoMemoBool = false, recMemoBool = false, diagBool = false; // which type of dynamic programming to run
 bool printBool = false; // whether to print table
 bool readFileBool = false, genStringsBool = false; // whether to read in strings from file or generate strings randomly
+bool cacheBool = false; // whether to look up and store results in the result cache
+char *cacheFilename; // file backing the persistent tier of the result cache (NULL if in-memory only)
+bool outOfCoreBool = false; // whether to keep only checkpoint rows of the table, on disk
+char *scratchFilename; // scratch file holding the checkpoint rows
+long memBudget; // memory budget in MB for out-of-core traceback (0 to choose automatically)
+uint64_t seed; // seed for generating strings
+bool seedBool = false; // whether seed was given (otherwise based on current time)
+bool mutateBool = false; // whether y is generated as a mutated copy of x
+double subRate, indelRate; // substitution and indel rates for mutated copy
+char *outFilename; // file to write generated strings to
+bool writeBool = false; // whether to write generated strings to file
+char *dumpPrefix; // prefix of files to dump dynamic programming tables to
+bool dumpBool = false; // whether to dump dynamic programming tables
+char *viewFilename; // dump file to render
+int viewWindow[4]; // rows and columns of dump file to render (first row, last row, first column, last column)
+bool viewBool = false; // whether to render a dump file instead of running an algorithm
+char *socketFilename; // Unix domain socket the daemon listens on
+int daemonThreads = 0; // num of threads serving daemon requests (0 for one per processor)
+bool daemonBool = false; // whether to run as a daemon instead of running an algorithm once
 
 // additions
 int **table; // dynamic prog table
@@ -43,6 +77,19 @@ bool isNum(char s[]) {
 	return isDigit;
 }
 
+// determine whether a given string is a rate between 0 and 1 (digits with at most one decimal point)
+bool isRate(char s[]) {
+	int i, points = 0;
+	bool valid = strlen(s) > 0;
+	for (i=0; i<strlen(s); i++) {
+		if (s[i]=='.')
+			points++;
+		else
+			valid &= s[i]>='0' && s[i]<='9';
+	}
+	return valid && points <= 1 && strcmp(s, ".") != 0 && atof(s) <= 1.0;
+}
+
 // get arguments from command line and check for validity (return true if and only if arguments illegal)
 bool getArgs(int argc, char *argv[]) {
 	int i;
@@ -62,6 +109,34 @@ bool getArgs(int argc, char *argv[]) {
 			else
 				return true; // must have been an error with -g arguments
 		}
+		else if (strcmp(argv[i],"-s")==0 || strcmp(argv[i],"--seed")==0) { // seed for generating strings
+			if (argc>=i+2 && isNum(argv[i+1])) { // must be one numerical argument after this
+				i++;
+				seed = strtoull(argv[i], NULL, 10);
+				seedBool = true;
+			}
+			else
+				return true; // must have been an error with seed argument
+		}
+		else if (strcmp(argv[i],"--mutate")==0) { // generate y as mutated copy of x
+			if (argc>=i+3 && isRate(argv[i+1]) && isRate(argv[i+2])) { // must be two rates after this
+				subRate = atof(argv[i+1]);
+				indelRate = atof(argv[i+2]);
+				mutateBool = true;
+				i+=2;
+			}
+			else
+				return true; // must have been an error with --mutate arguments
+		}
+		else if (strcmp(argv[i],"-w")==0) { // write generated strings to file
+			if (argc>=i+2) { // must be one more argument (filename) after this
+				i++;
+				outFilename = argv[i];
+				writeBool = true;
+			}
+			else
+				return true; // must have been an error with -w argument
+		}
 		else if (strcmp(argv[i],"-f")==0) { // read in strings from file
 			if (argc>=i+2) { // must be one more argument (filename) after this)
 				i++;
@@ -77,8 +152,61 @@ bool getArgs(int argc, char *argv[]) {
 			recNoMemoBool = true;
 		else if (strcmp(argv[i],"-m")==0) // recursive dynamic programming with memoisation
 			recMemoBool = true;
+		else if (strcmp(argv[i],"-u")==0) // diagonal-transition edit distance
+			diagBool = true;
 		else if (strcmp(argv[i],"-p")==0) // print dynamic programming table
 			printBool = true;
+		else if (strcmp(argv[i],"-o")==0) { // out-of-core dynamic programming
+			if (argc>=i+3 && isNum(argv[i+2])) { // must be scratch filename and memory budget after this
+				scratchFilename = argv[i+1];
+				memBudget = atol(argv[i+2]);
+				outOfCoreBool = true;
+				i+=2;
+			}
+			else
+				return true; // must have been an error with -o arguments
+		}
+		else if (strcmp(argv[i],"-d")==0) { // dump dynamic programming tables in binary
+			if (argc>=i+2) { // must be one more argument (filename prefix) after this
+				i++;
+				dumpPrefix = argv[i];
+				dumpBool = true;
+			}
+			else
+				return true; // must have been an error with -d argument
+		}
+		else if (strcmp(argv[i],"-v")==0) { // render window of a dump file
+			if (argc>=i+6 && isNum(argv[i+2]) && isNum(argv[i+3]) && isNum(argv[i+4]) && isNum(argv[i+5])) { // must be filename and four numerical arguments after this
+				viewFilename = argv[i+1];
+				int k;
+				for (k = 0; k < 4; k++)
+					viewWindow[k] = atoi(argv[i+2+k]);
+				viewBool = true;
+				i+=5;
+			}
+			else
+				return true; // must have been an error with -v arguments
+		}
+		else if (strcmp(argv[i],"-D")==0) { // run as daemon
+			if (argc>=i+2) { // must be socket path after this, optionally followed by num of threads
+				i++;
+				socketFilename = argv[i];
+				daemonBool = true;
+				if (argc>=i+2 && isNum(argv[i+1])) {
+					i++;
+					daemonThreads = atoi(argv[i]);
+				}
+			}
+			else
+				return true; // must have been an error with -D arguments
+		}
+		else if (strcmp(argv[i],"-c")==0) { // cache results, optionally persisting them to a file
+			cacheBool = true;
+			if (argc>=i+2 && argv[i+1][0]!='-') { // optional filename after this
+				i++;
+				cacheFilename = argv[i];
+			}
+		}
 		else if (strcmp(argv[i],"-t")==0) // which algorithm to run
 			if (argc>=i+2) { // must be one more argument ("LCS" or "ED" or "SW")
 				i++;
@@ -104,12 +232,27 @@ bool getArgs(int argc, char *argv[]) {
 				return true; // algorithm type not given
 		else
 			return true; // argument not recognised
+		// rendering a dump file must be the only choice
+		if (viewBool)
+			return argc != 7;
+		// running as daemon may only be combined with the result cache
+		if (daemonBool)
+			return viewBool || readFileBool || genStringsBool || alg_type!=NONE || iterBool || recMemoBool || recNoMemoBool || diagBool
+				|| printBool || outOfCoreBool || dumpBool || seedBool || mutateBool || writeBool;
 		// check for legal combination of choices; return true (illegal) if user chooses:
 		// - neither or both of generate strings and read strings from file
 		// - generate strings with length 0 or alphabet size 0
 		// - no algorithm to run
 		// - no type of dynamic programming
-		return !(readFileBool ^ genStringsBool) || (genStringsBool && (xLen <=0 || yLen <= 0 || alphabetSize <=0)) || alg_type==NONE || (!iterBool && !recMemoBool && !recNoMemoBool);
+		// - out-of-core mode for anything but iterative LCS
+		// - seed, mutation or writing strings to file without generating strings
+		// - writing strings to file with an alphabet large enough that chars from 'A' on wrap round to '\n' (so '\r' too)
+		// - dumping tables that are not held in memory (out-of-core mode)
+		// - diagonal transition for anything but ED, or with printing or dumping tables (it keeps no table)
+		return !(readFileBool ^ genStringsBool) || (genStringsBool && (xLen <=0 || yLen <= 0 || alphabetSize <=0)) || alg_type==NONE || (!iterBool && !recMemoBool && !recNoMemoBool && !diagBool)
+			|| (outOfCoreBool && (alg_type!=LCS || !iterBool))
+			|| (!genStringsBool && (seedBool || mutateBool || writeBool)) || (writeBool && alphabetSize > 256 + '\n' - 'A')
+			|| (outOfCoreBool && dumpBool) || (diagBool && (alg_type!=ED || printBool || dumpBool));
 }
 
 // read strings from file; return true if and only if file read successfully
@@ -176,20 +319,159 @@ bool readStrings() {
 	}
 }
 
-// generate two strings x and y (of lengths xLen and yLen respectively) uniformly at random over an alphabet of size alphabetSize
+/************************** STRING GENERATION ******************************/
+/** strings are filled in fixed-size chunks, each drawn from its own stream, so the **/
+/** output depends only on the seed and not on the number of threads **/
+
+#define GEN_CHUNK 65536 // num of chars per chunk
+
+char *genTarget; // string being filled by fillChunk
+long genLen; // length of that string
+int genStream; // stream id of that string (0 for x, 1 for y, 2 for mutations)
+char **mutChunks; // mutated chunks of x, concatenated to form y
+long *mutLens; // lengths of mutated chunks
+long genNext; // next chunk to be taken by a thread
+long genChunks; // num of chunks in current job
+void (*genFn)(long); // function run on each chunk of current job
+
+// splitmix64: advance state and return next pseudo-random value
+static inline uint64_t nextRand(uint64_t *state) {
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+// starting state of the stream for a given chunk of a given string
+uint64_t chunkState(int stream, long chunk) {
+	uint64_t s = seed ^ ((uint64_t)stream << 56) ^ ((uint64_t)chunk * 0xd1b54a32d192ed03ULL);
+	return nextRand(&s);
+}
+
+// uniform value in [0, n) without modulo bias (multiply-shift with rejection)
+static inline uint32_t randBelow(uint64_t *state, uint32_t n) {
+	uint32_t threshold = -n % n; // low halves below this would over-represent some values
+	uint64_t m;
+	do
+		m = (uint64_t)(uint32_t)nextRand(state) * n;
+	while ((uint32_t)m < threshold);
+	return m >> 32;
+}
+
+// true with the given probability (p * 2^64 only fits in 64 bits below 1)
+static inline bool randChance(uint64_t *state, double p) {
+	if (p >= 1.0)
+		return true;
+	return nextRand(state) < (uint64_t)(p * 18446744073709551616.0);
+}
+
+// fill one chunk of genTarget uniformly at random over the alphabet
+void fillChunk(long c) {
+	uint64_t state = chunkState(genStream, c);
+	long i, end = MIN(genLen, (c+1) * GEN_CHUNK);
+	for (i = c * GEN_CHUNK; i < end; i++)
+		genTarget[i] = randBelow(&state, alphabetSize) + 'A';
+}
+
+// apply substitutions and indels to one chunk of x, giving one chunk of y
+void mutateChunk(long c) {
+	uint64_t state = chunkState(2, c);
+	long i, end = MIN((long)xLen, (c+1) * GEN_CHUNK), n = 0;
+	char *out = malloc(2 * GEN_CHUNK); // at most one insertion per char
+	for (i = c * GEN_CHUNK; i < end; i++) {
+		char ch = x[i];
+		if (randChance(&state, indelRate)) {
+			if (nextRand(&state) & 1) // insertion before this char
+				out[n++] = randBelow(&state, alphabetSize) + 'A';
+			else // deletion of this char
+				continue;
+		}
+		if (alphabetSize > 1 && randChance(&state, subRate)) // substitution by a different char
+			ch = ((unsigned char)(ch - 'A') + 1 + randBelow(&state, alphabetSize - 1)) % alphabetSize + 'A';
+		out[n++] = ch;
+	}
+	mutChunks[c] = out;
+	mutLens[c] = n;
+}
+
+// thread body: take chunks of the current job until none are left
+void *genWorker(void *arg) {
+	long c;
+	while ((c = __atomic_fetch_add(&genNext, 1, __ATOMIC_RELAXED)) < genChunks)
+		genFn(c);
+	return NULL;
+}
+
+// run fn on chunks 0..chunks-1, spread over the available processors
+void runChunks(long chunks, void (*fn)(long)) {
+	long threads = MIN(sysconf(_SC_NPROCESSORS_ONLN), chunks), t;
+	pthread_t tids[threads > 0 ? threads : 1];
+	genFn = fn;
+	genChunks = chunks;
+	genNext = 0;
+	// chunks are shared out dynamically, so fewer threads than asked for only makes this slower
+	long started = 1;
+	for (t = 1; t < threads; t++)
+		if (pthread_create(&tids[started], NULL, genWorker, NULL) == 0)
+			started++;
+	genWorker(NULL); // this thread works too
+	for (t = 1; t < started; t++)
+		pthread_join(tids[t], NULL);
+}
+
+// generate two strings x and y (of lengths xLen and yLen respectively) uniformly at random over an alphabet of size alphabetSize;
+// if mutating, y is instead a copy of x with substitutions and indels at the given rates
 void generateStrings() {
-	// allocate memory for x and y
+	long c, chunks;
+	// allocate memory for x and generate it
 	x = malloc(xLen * sizeof(char));
-	y = malloc(yLen * sizeof(char));
-	// instantiate the pseudo-random number generator (seeded based on current time)
-	srand(time(NULL));
-	int i;
-	// generate x, of length xLen
-	for (i = 0; i < xLen; i++)
-		x[i] = rand()%alphabetSize +'A';
-	// generate y, of length yLen
-	for (i = 0; i < yLen; i++)
-		y[i] = rand()%alphabetSize +'A';
+	genTarget = x;
+	genLen = xLen;
+	genStream = 0;
+	runChunks((genLen + GEN_CHUNK - 1) / GEN_CHUNK, fillChunk);
+	if (mutateBool) {
+		// mutate each chunk of x, then join the mutated chunks to form y
+		chunks = (xLen + GEN_CHUNK - 1) / GEN_CHUNK;
+		mutChunks = malloc(chunks * sizeof(char *));
+		mutLens = malloc(chunks * sizeof(long));
+		runChunks(chunks, mutateChunk);
+		long len = 0;
+		for (c = 0; c < chunks; c++)
+			len += mutLens[c];
+		yLen = MAX(len, 1); // y must not be empty
+		y = malloc(yLen * sizeof(char));
+		y[0] = 'A';
+		for (len = 0, c = 0; c < chunks; c++) {
+			memcpy(y + len, mutChunks[c], mutLens[c]);
+			len += mutLens[c];
+			free(mutChunks[c]);
+		}
+		free(mutChunks);
+		free(mutLens);
+	}
+	else {
+		// allocate memory for y and generate it
+		y = malloc(yLen * sizeof(char));
+		genTarget = y;
+		genLen = yLen;
+		genStream = 1;
+		runChunks((genLen + GEN_CHUNK - 1) / GEN_CHUNK, fillChunk);
+	}
+}
+
+// write generated strings to file in the format read by readStrings; return true if and only if successful
+bool writeStrings() {
+	FILE *file = fopen(outFilename, "w");
+	if (!file) {
+		printf("Problem opening file %s\n", outFilename);
+		return false;
+	}
+	bool ok = fwrite(x, 1, xLen, file) == (size_t)xLen && fputc('\n', file) != EOF
+		&& fwrite(y, 1, yLen, file) == (size_t)yLen && fputc('\n', file) != EOF;
+	ok &= fclose(file) == 0;
+	if (!ok)
+		printf("Problem writing file %s\n", outFilename);
+	return ok;
 }
 
 // free memory occupied by strings
@@ -355,6 +637,213 @@ void printPairsTable(int xLen, int yLen) {
 	}
 }
 
+/************************** BINARY TABLE DUMPS *****************************/
+/** header, then x and y (padded to 4 bytes), then the table as int32 values row by row, **/
+/** then for memoisation tables a bit per entry, set if and only if it was evaluated. **/
+/** all fields are in the byte order of the machine that wrote the dump, which is recorded **/
+/** in the header; dumps are only read back on machines with the same byte order **/
+
+#define DUMP_MAGIC "ASXDUMP" // identifies a dump file
+#define DUMP_VERSION 2 // bumped whenever the layout changes
+#define DUMP_BYTE_ORDER 0x01020304 // written natively; reads back differently on a machine of other byte order
+#define DUMP_BUFFER (1 << 20) // size of write buffer
+
+enum {DUMP_TABLE, DUMP_PAIRS}; // kinds of dump
+
+typedef struct dumpHeader { // header at the start of a dump file
+	char magic[8];
+	uint32_t version;
+	uint32_t kind; // DUMP_TABLE or DUMP_PAIRS
+	int32_t alg; // which algorithm (alg_type)
+	int32_t xLen, yLen; // lengths of the strings
+	uint32_t byteOrder; // DUMP_BYTE_ORDER in the writer's byte order
+} DumpHeader;
+
+_Static_assert(sizeof(int) == sizeof(int32_t), "table entries are dumped as int32 values");
+
+// offset of the table in a dump file
+static inline size_t dumpTableOffset(int xLen, int yLen) {
+	return (sizeof(DumpHeader) + xLen + yLen + 3) & ~(size_t)3;
+}
+
+// open a dump file named prefix-suffix.asx and write header and strings; return NULL on failure
+FILE *dumpOpen(char *suffix, int kind, char *buffer) {
+	char name[strlen(dumpPrefix) + strlen(suffix) + 6];
+	sprintf(name, "%s-%s.asx", dumpPrefix, suffix);
+	FILE *file = fopen(name, "wb");
+	if (!file) {
+		printf("Problem opening file %s\n", name);
+		return NULL;
+	}
+	setvbuf(file, buffer, _IOFBF, DUMP_BUFFER);
+	DumpHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DUMP_MAGIC, 8);
+	header.version = DUMP_VERSION;
+	header.kind = kind;
+	header.byteOrder = DUMP_BYTE_ORDER;
+	header.alg = alg_type;
+	header.xLen = xLen;
+	header.yLen = yLen;
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(x, 1, xLen, file);
+	fwrite(y, 1, yLen, file);
+	size_t pad = dumpTableOffset(xLen, yLen) - sizeof(DumpHeader) - xLen - yLen;
+	fwrite("\0\0\0", 1, pad, file);
+	printf("Dynamic programming table dumped to %s\n", name);
+	return file;
+}
+
+// close a dump file, reporting write errors
+void dumpClose(FILE *file) {
+	if (ferror(file) | fclose(file))
+		printf("Problem writing dump file\n");
+}
+
+// dump dynamic programming table
+void dumpTable(int xLen, int yLen, char *suffix) {
+	char *buffer = malloc(DUMP_BUFFER);
+	FILE *file = dumpOpen(suffix, DUMP_TABLE, buffer);
+	int i;
+	if (file) {
+		for (i = 0; i <= xLen; i++) // rows are written whole
+			fwrite(table[i], sizeof(int), yLen+1, file);
+		dumpClose(file);
+	}
+	free(buffer);
+}
+
+// dump dynamic programming table of pairs along with the mask of evaluated entries
+void dumpPairsTable(int xLen, int yLen) {
+	char *buffer = malloc(DUMP_BUFFER);
+	FILE *file = dumpOpen("memo", DUMP_PAIRS, buffer);
+	if (file) {
+		size_t cells = (size_t)(xLen+1) * (yLen+1);
+		unsigned char *mask = calloc((cells + 7) / 8, 1);
+		int32_t *row = malloc((yLen+1) * sizeof(int32_t));
+		size_t cell = 0;
+		int i, j;
+		for (i = 0; i <= xLen; i++) {
+			for (j = 0; j <= yLen; j++, cell++) {
+				if (evaluated(i, j)) {
+					row[j] = pairsTable[i][j].i;
+					mask[cell / 8] |= 1 << (cell % 8);
+				}
+				else
+					row[j] = 0; // never written by the algorithm
+			}
+			fwrite(row, sizeof(int32_t), yLen+1, file);
+		}
+		fwrite(mask, 1, (cells + 7) / 8, file);
+		free(row);
+		free(mask);
+		dumpClose(file);
+	}
+	free(buffer);
+}
+
+// print rows r0..r1 and columns c0..c1 of a dump file in the layout of printTable/printPairsTable;
+// return true if and only if the file could be read
+bool renderDump(char *name, int r0, int r1, int c0, int c1) {
+	int fd = open(name, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		printf("Problem opening file %s\n", name);
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+	char *map = st.st_size >= (off_t)sizeof(DumpHeader) ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (map == MAP_FAILED) {
+		printf("Incorrect dump file syntax\n");
+		return false;
+	}
+
+	// check header
+	DumpHeader *header = (DumpHeader *)map;
+	if (memcmp(header->magic, DUMP_MAGIC, 8) != 0 || header->version != DUMP_VERSION || header->kind > DUMP_PAIRS) {
+		printf("Incorrect dump file syntax\n");
+		munmap(map, st.st_size);
+		return false;
+	}
+	if (header->byteOrder != DUMP_BYTE_ORDER) {
+		printf("Dump file written on a machine of different byte order\n");
+		munmap(map, st.st_size);
+		return false;
+	}
+
+	// check that the file is long enough for what it claims to hold; lengths are bounded by
+	// the file size before any arithmetic on them, so nothing below can overflow
+	int xLen = header->xLen, yLen = header->yLen;
+	size_t fileSize = st.st_size, cells = 0;
+	bool valid = xLen >= 0 && yLen >= 0 && (size_t)xLen + yLen <= fileSize;
+	if (valid) {
+		cells = ((size_t)xLen + 1) * ((size_t)yLen + 1);
+		valid = cells <= fileSize / sizeof(int32_t)
+			&& dumpTableOffset(xLen, yLen) + cells * sizeof(int32_t) + (header->kind == DUMP_PAIRS ? (cells + 7) / 8 : 0) <= fileSize;
+	}
+	if (!valid) {
+		printf("Incorrect dump file syntax\n");
+		munmap(map, st.st_size);
+		return false;
+	}
+	char *x = map + sizeof(DumpHeader);
+	char *y = x + xLen;
+	int32_t *values = (int32_t *)(map + dumpTableOffset(xLen, yLen));
+	unsigned char *mask = (unsigned char *)(values + cells);
+	bool pairs = header->kind == DUMP_PAIRS;
+
+	// clamp window to the table
+	r0 = MAX(r0, 0);
+	c0 = MAX(c0, 0);
+	r1 = MIN(r1, xLen);
+	c1 = MIN(c1, yLen);
+
+	// width of entries: first entry (usually largest) for tables, fixed for pairs
+	int w = pairs ? 2 : numDigits(values[0]) + 1;
+	int i, j, k;
+
+	// first row
+	printf ("%2s%2s%2s", " ", " ", " ");
+	for (j = c0; j <= c1; j++)
+		printf("%*d", w, j);
+
+	// second row
+	printf ("\n%2s%2s%2s", " ", " ", " ");
+	for (j = c0; j <= c1; j++)
+		if (j == 0)
+			printf("%*s", w, " ");
+		else
+			printf("%*c", w, y[j-1]);
+
+	// third row
+	printf ("\n%2s%2s%2s", " ", " ", " ");
+	for (j = c0; j <= c1; j++)
+		for (k = 0; k < w; k++)
+			printf("%1s", "_");
+	printf("\n");
+
+	// rows of the window
+	for (i = r0; i <= r1; i++) {
+		if (i == 0)
+			printf("%2s%2s%2s", "0", " ", "|");
+		else
+			printf("%2d%2c%2s", i, x[i-1], "|");
+		for (j = c0; j <= c1; j++) {
+			size_t cell = (size_t)i * (yLen+1) + j;
+			if (pairs && !(mask[cell / 8] & (1 << (cell % 8))))
+				printf("%*s", w, "-");
+			else
+				printf("%*d", w, values[cell]);
+		}
+		printf("\n");
+	}
+
+	munmap(map, st.st_size);
+	return true;
+}
+
 // function to print the optimal alignment for iterative LCS
 void ilcsAlign(int xLen, int yLen) {
 	int index = table[xLen][yLen]; // length of lcs
@@ -487,9 +976,20 @@ void mlcsAlign(int xLen, int yLen) {
 
 /*************** LONGEST COMMON SUBSEQUENCE ALGORITHM *********************/
 
+// compute entries 1..n of an LCS table row for char c of x from the previous row (cur[0] must be set);
+// every LCS version that works a row at a time goes through here
+static inline void lcsStep(const int *prev, int *cur, char c, const char *y, int n) {
+	int j;
+	for (j = 1; j <= n; j++)
+		if (c == y[j-1])
+			cur[j] = prev[j-1] + 1;
+		else
+			cur[j] = MAX(prev[j], cur[j-1]);
+}
+
 // iterative LCS
 int lcs(char *x, char *y) {
-	int i, j = 0;
+	int i;
 
 	// create and initialise table
 	createTable(xLen, yLen);
@@ -497,11 +997,7 @@ int lcs(char *x, char *y) {
 
 	// calculate rest of values
 	for (i = 1; i <= xLen; i++)
-		for (j = 1; j <= yLen; j++)
-			if (x[i-1] == y[j-1])
-				table[i][j] = table[i-1][j-1] + 1;
-			else
-				table[i][j] = MAX(table[i-1][j], table[i][j-1]);
+		lcsStep(table[i-1], table[i], x[i-1], y, yLen);
 
 	// return the bottom-right value(length of largest common subsequence)
 	return table[xLen][yLen];
@@ -554,8 +1050,161 @@ int mlcs(int m, int n) {
 	return pairsTable[m][n].i;
 }
 
+/******************* OUT-OF-CORE LONGEST COMMON SUBSEQUENCE ******************/
+/** only every k-th row of the table is kept, in a memory-mapped scratch file; **/
+/** traceback recomputes one stripe of k rows at a time from its checkpoint **/
+
+int *checkpoints; // checkpoint rows 0, k, 2k, ... of the table (mapped from scratch file)
+size_t checkpointsBytes; // size of the mapping
+int stride; // k, the num of rows between checkpoints
+int **stripe; // rows recomputed between two checkpoints (stride+1 rows)
+
+// pointer to checkpoint row c*stride
+static inline int *checkpointRow(int c) {
+	return checkpoints + (size_t)c * (yLen+1);
+}
+
+// out-of-core iterative LCS; returns -1 if the scratch file or memory budget is unusable
+int oocLcs(int xLen, int yLen) {
+	size_t rowBytes = (size_t)(yLen+1) * sizeof(int);
+	int i, row;
+
+	// choose stride: stripe of stride+1 rows must fit in budget; about sqrt(m) rows if no budget given
+	if (memBudget > 0) {
+		size_t rows = ((size_t)memBudget << 20) / rowBytes;
+		if (rows < 2) {
+			printf("Memory budget too small for rows of length %d\n", yLen);
+			return -1;
+		}
+		stride = (int)MIN(rows - 1, (size_t)xLen);
+	}
+	else
+		stride = MAX(1, (int)ceil(sqrt((double)xLen)));
+
+	// create scratch file and map it; unlinked straight away so it never outlives this process
+	int fd = open(scratchFilename, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		printf("Problem opening scratch file %s\n", scratchFilename);
+		return -1;
+	}
+	unlink(scratchFilename);
+	checkpointsBytes = (size_t)(xLen/stride + 1) * rowBytes;
+	if (ftruncate(fd, checkpointsBytes) != 0) {
+		printf("Problem growing scratch file %s\n", scratchFilename);
+		close(fd);
+		return -1;
+	}
+	checkpoints = mmap(NULL, checkpointsBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (checkpoints == MAP_FAILED) {
+		printf("Problem mapping scratch file %s\n", scratchFilename);
+		return -1;
+	}
+
+	// stripe is allocated up front so the forward pass stays within the budget as well
+	stripe = (int **)malloc((stride+1)*sizeof(int *));
+	for (row = 0; row <= stride; row++) {
+		stripe[row] = (int *)malloc(rowBytes);
+		stripe[row][0] = 0; // column 0 is never written by lcsStep
+	}
+
+	// forward pass over two rows, writing every stride-th row out as a checkpoint
+	memset(stripe[0], 0, rowBytes);
+	memcpy(checkpointRow(0), stripe[0], rowBytes);
+	for (i = 1; i <= xLen; i++) {
+		lcsStep(stripe[(i-1)&1], stripe[i&1], x[i-1], y, yLen);
+		if (i % stride == 0)
+			memcpy(checkpointRow(i/stride), stripe[i&1], rowBytes);
+	}
+
+	// return the bottom-right value (length of longest common subsequence)
+	return stripe[xLen&1][yLen];
+}
+
+// print the optimal alignment for out-of-core LCS, one stripe at a time
+void oocAlign(int xLen, int yLen, int index) {
+	int l = xLen + yLen - index; // length of alignment
+	char *newX = malloc(l+1); // string x to print
+	char *newY = malloc(l+1); // string y to print
+	char *align = malloc(l+1); // show alignment
+	newX[l] = '\0';
+	newY[l] = '\0';
+	align[l] = '\0';
+	memset(newX, '-', l);
+	memset(newY, '-', l);
+	memset(align, ' ', l);
+
+	int i = xLen;
+	int j = yLen;
+	while (i > 0 && j > 0) {
+		// recompute rows c..i, where c is the nearest checkpoint below row i
+		int c = ((i-1)/stride) * stride;
+		int r;
+		memcpy(stripe[0], checkpointRow(c/stride), (size_t)(yLen+1)*sizeof(int));
+		for (r = 1; r <= i-c; r++)
+			lcsStep(stripe[r-1], stripe[r], x[c+r-1], y, yLen);
+
+		// trace back within the stripe, as in ilcsAlign
+		while (i > c && j > 0) {
+			if (x[i-1] == y[j-1]) { // chars match
+				newX[l-1] = x[i-1];
+				newY[l-1] = y[j-1];
+				align[l-1] = '|';
+				i--;
+				j--;
+			} else if (stripe[i-c-1][j] > stripe[i-c][j-1]) { // deletion
+				newX[l-1] = x[i-1];
+				i--;
+			}	else { // insertion
+				newY[l-1] = y[j-1];
+				j--;
+			}
+			l--;
+		}
+	}
+
+	// fill up front non-matching chars
+	while (i > 0) {
+		newX[l-1] = x[i-1];
+		i--;
+		l--;
+	}
+	while (j > 0) {
+		newY[l-1] = y[j-1];
+		j--;
+		l--;
+	}
+
+	printf("\nOptimal Alignment:\n");
+	printf("%s\n", newX);
+	printf("%s\n", align);
+	printf("%s\n", newY);
+	free(newX);
+	free(newY);
+	free(align);
+}
+
+// free memory used by stripe and unmap checkpoints
+void destroyCheckpoints() {
+	int row;
+	for (row = 0; row <= stride; row++)
+		free(stripe[row]);
+	free(stripe);
+	munmap(checkpoints, checkpointsBytes);
+}
+
 /********************* EDIT DISTANCE ALGORITHM *****************************/
 
+// compute entries 1..n of an ED table row for char c of x from the previous row (cur[0] must be set)
+static inline void edStep(const int *prev, int *cur, char c, const char *y, int n) {
+	int j;
+	for (j = 1; j <= n; j++)
+		if (c == y[j-1])
+			cur[j] = prev[j-1];
+		else
+			cur[j] = MIN(prev[j], MIN(cur[j-1], prev[j-1])) + 1;
+}
+
 // iterative ED
 int ed(char *x, char *y) {
 	int i, j = 0;
@@ -571,11 +1220,7 @@ int ed(char *x, char *y) {
 
 	// calculate rest of edit distance
 	for (i = 1; i <= xLen; i++)
-		for (j = 1; j <= yLen; j++)
-			if (x[i-1] == y[j-1])
-				table[i][j] = table[i-1][j-1];
-			else
-				table[i][j] = MIN(table[i-1][j], MIN(table[i][j-1], table[i-1][j-1])) + 1;
+		edStep(table[i-1], table[i], x[i-1], y, yLen);
 
 	// return the bottom-right value(length of largest common subsequence)
 	return table[xLen][yLen];
@@ -631,12 +1276,112 @@ int med(int m, int n) {
 	return pairsTable[m][n].i;
 }
 
+// diagonal-transition ED -- length of longest common extension of x[i..] and y[j..], compared a word at a time
+static inline int lce(const char *x, int i, int m, const char *y, int j, int n) {
+	int start = i;
+	uint64_t a, b;
+	while (i + 8 <= m && j + 8 <= n) {
+		memcpy(&a, x + i, 8);
+		memcpy(&b, y + j, 8);
+		if (a != b) // count equal bytes before the first differing one
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			return i - start + (__builtin_ctzll(a ^ b) >> 3);
+#else
+			return i - start + (__builtin_clzll(a ^ b) >> 3);
+#endif
+		i += 8;
+		j += 8;
+	}
+	while (i < m && j < n && x[i] == y[j]) {
+		i++;
+		j++;
+	}
+	return i - start;
+}
+
+// ED over two rows as long as the shorter string (ED is symmetric); time O(mn), space O(min(m,n))
+int edRows(const char *x, int m, const char *y, int n) {
+	if (n > m)
+		return edRows(y, n, x, m);
+	int *buf = malloc(2 * (n+1) * sizeof(int));
+	int *prev = buf, *cur = buf + n + 1, *tmp;
+	int i, j, d;
+	for (j = 0; j <= n; j++)
+		prev[j] = j;
+	for (i = 1; i <= m; i++) {
+		cur[0] = i;
+		edStep(prev, cur, x[i-1], y, n);
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+	d = prev[n];
+	free(buf);
+	return d;
+}
+
+// diagonal-transition ED (Ukkonen / Landau-Vishkin): for d = 0, 1, ... find the furthest row reachable
+// on each diagonal k = j - i with d edits, until the bottom-right entry is reached; time O((m+n)d).
+// Once (m+n)d would exceed mn the rest is left to edRows, so time is O(min((m+n)d, mn))
+int dted(char *x, char *y) {
+	const int NEG = -1; // diagonal not reached yet
+	int m = xLen, n = yLen, d, k;
+	int size = m + n + 3; // diagonals -m-1..n+1
+	int *buf = malloc(2 * size * sizeof(int));
+	int *prev = buf + m + 1, *cur = buf + size + m + 1, *tmp;
+	for (k = 0; k < 2 * size; k++)
+		buf[k] = NEG;
+
+	// no edits: slide down the main diagonal
+	cur[0] = lce(x, 0, m, y, 0, n);
+	for (d = 0; cur[n-m] != m; ) {
+		d++;
+		if ((long)d * (m+n) > (long)m * n) { // diagonals now cost more than the whole table
+			free(buf);
+			return edRows(x, m, y, n);
+		}
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+		for (k = MAX(-d, -m); k <= MIN(d, n); k++) {
+			int i = prev[k]; // same point
+			if (prev[k] != NEG && prev[k] < m && prev[k] + k < n) // substitution
+				i = prev[k] + 1;
+			if (prev[k+1] != NEG && prev[k+1] < m) // deletion, from diagonal k+1
+				i = MAX(i, prev[k+1] + 1);
+			if (prev[k-1] != NEG && prev[k-1] + k <= n) // insertion, from diagonal k-1
+				i = MAX(i, prev[k-1]);
+			if (i != NEG)
+				i += lce(x, i, m, y, i + k, n);
+			cur[k] = i;
+		}
+	}
+
+	free(buf);
+	return d;
+}
+
 /********************** SMITH-WATERMAN ALORITHM ****************************/
 /** i.e. length of the highest scoring local similarity **/
 
+// compute entries 1..n of an SW table row for char c of x from the previous row (cur[0] must be set);
+// returns the best score in the row
+static inline int swStep(const int *prev, int *cur, char c, const char *y, int n) {
+	int j, bestScore = 0;
+	for (j = 1; j <= n; j++) {
+		if (c == y[j-1])
+			cur[j] = prev[j-1] + 1;
+		else
+			cur[j] = MAX(prev[j] - 1, MAX(cur[j-1] - 1, MAX(prev[j-1] - 1, 0)));
+		if (cur[j] > bestScore)
+			bestScore = cur[j];
+	}
+	return bestScore;
+}
+
 // iterative version
 int hsls(char *x, char *y) {
-	int i, j, bestScore = 0;
+	int i, bestScore = 0;
 
 	// create and initialise table
 	createTable(xLen, yLen);
@@ -644,19 +1389,963 @@ int hsls(char *x, char *y) {
 
 	// calculate rest of values, keeping track of bestScore
 	for (i = 1; i <= xLen; i++)
-		for (j = 1; j <= yLen; j++) {
-			if (x[i-1] == y[j-1])
-				table[i][j] = table[i-1][j-1] + 1;
-			else
-				table[i][j] = MAX(table[i-1][j] - 1, MAX(table[i][j-1] - 1, MAX(table[i-1][j-1] - 1, 0)));
-			if (table[i][j] > bestScore)
-				bestScore = table[i][j];
-		}
+		bestScore = MAX(bestScore, swStep(table[i-1], table[i], x[i-1], y, yLen));
 
 	// return the bottom-right value(length of largest common subsequence)
 	return bestScore;
 }
 
+/************************** RESULT CACHE ***********************************/
+/** results keyed by a hash of both strings, the algorithm and the dynamic programming version **/
+
+#define CACHE_CAPACITY 4096 // number of entries kept in the in-memory LRU tier
+#define CACHE_BUCKETS 8192 // number of hash buckets for the in-memory tier
+#define CACHE_MAGIC "ASXCACHE" // identifies a cache file
+#define CACHE_VERSION 1 // bumped whenever the record layout changes
+#define CACHE_INITIAL_RECORDS 1024 // records a cache file grows to on its first append
+
+enum {ITERATIVE, MEMOISED, RECURSIVE}; // dynamic programming versions, part of the cache key
+
+typedef struct cacheKey { // def of cache key
+	uint64_t xHash; // hash of string x
+	uint64_t yHash; // hash of string y
+	int32_t xLen, yLen; // lengths of the strings
+	int32_t alg; // which algorithm (alg_type)
+	int32_t variant; // which dynamic programming version
+} CacheKey;
+
+typedef struct cacheEntry { // def of cache entry; also the on-disk record
+	CacheKey key;
+	int32_t result; // value printed as result of the algorithm
+	int32_t aux; // extra output (number of table entries computed for memoisation)
+} CacheEntry;
+
+typedef struct cacheNode { // node of the in-memory LRU tier
+	CacheEntry entry;
+	int prev, next; // neighbours in recency list (-1 if none)
+	int chain; // next node in same hash bucket (-1 if none)
+} CacheNode;
+
+typedef struct cacheHeader { // header at the start of a cache file
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t records; // number of committed records following the header
+} CacheHeader;
+
+CacheNode cacheNodes[CACHE_CAPACITY]; // in-memory tier
+int cacheBuckets[CACHE_BUCKETS]; // first node in each bucket (-1 if empty)
+int cacheHead = -1, cacheTail = -1; // most and least recently used nodes
+int cacheSize = 0; // num of nodes in use
+uint64_t cacheXHash, cacheYHash; // hashes of the current strings x and y
+
+int cacheFd = -1; // file descriptor of the persistent tier (-1 if not open)
+CacheHeader *cacheMap; // mapping of the cache file
+size_t cacheMapRecords; // num of records the mapping has room for
+uint32_t *cacheIndex; // open-addressing index of record numbers (+1, 0 if empty)
+size_t cacheIndexSize; // num of slots in the index (power of two)
+size_t cacheIndexed; // num of records in the index
+
+long cacheMemHits = 0, cacheDiskHits = 0, cacheMisses = 0; // hit/miss counts
+
+// multiply and fold 64-bit values; building block of hashString
+static inline uint64_t mix64(uint64_t a, uint64_t b) {
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+// fast hash of a string, reading it a word at a time
+uint64_t hashString(const char *s, int len) {
+	const uint64_t k0 = 0xa0761d6478bd642fULL, k1 = 0xe7037ed1a0b428dbULL;
+	uint64_t h = mix64((uint64_t)len ^ k0, k1);
+	uint64_t w;
+	int i;
+	for (i = 0; i + 8 <= len; i += 8) {
+		memcpy(&w, s + i, 8);
+		h = mix64(h ^ w ^ k0, k1);
+	}
+	w = 0;
+	memcpy(&w, s + i, len - i); // remaining bytes
+	return mix64(h ^ w ^ k1, k0 ^ (uint64_t)len);
+}
+
+// hash of a key, used for bucket and index positions
+static inline uint64_t keyHash(const CacheKey *key) {
+	return mix64(key->xHash ^ mix64(key->yHash, 0xe7037ed1a0b428dbULL),
+		((uint64_t)key->alg << 48) ^ ((uint64_t)key->variant << 40) ^ ((uint64_t)key->xLen << 20) ^ (uint64_t)key->yLen ^ 0xa0761d6478bd642fULL);
+}
+
+// unlink a node from the recency list
+void lruUnlink(int n) {
+	if (cacheNodes[n].prev >= 0)
+		cacheNodes[cacheNodes[n].prev].next = cacheNodes[n].next;
+	else
+		cacheHead = cacheNodes[n].next;
+	if (cacheNodes[n].next >= 0)
+		cacheNodes[cacheNodes[n].next].prev = cacheNodes[n].prev;
+	else
+		cacheTail = cacheNodes[n].prev;
+}
+
+// make a node the most recently used
+void lruPushFront(int n) {
+	cacheNodes[n].prev = -1;
+	cacheNodes[n].next = cacheHead;
+	if (cacheHead >= 0)
+		cacheNodes[cacheHead].prev = n;
+	cacheHead = n;
+	if (cacheTail < 0)
+		cacheTail = n;
+}
+
+// find a key in the in-memory tier; return node or -1
+int lruFind(const CacheKey *key) {
+	int n = cacheBuckets[keyHash(key) % CACHE_BUCKETS];
+	while (n >= 0 && memcmp(&cacheNodes[n].entry.key, key, sizeof(CacheKey)) != 0)
+		n = cacheNodes[n].chain;
+	return n;
+}
+
+// put an entry in the in-memory tier, evicting the least recently used one if full
+void lruPut(const CacheEntry *entry) {
+	int n = lruFind(&entry->key);
+	if (n >= 0) { // already present; update and refresh
+		cacheNodes[n].entry = *entry;
+		lruUnlink(n);
+		lruPushFront(n);
+		return;
+	}
+	if (cacheSize < CACHE_CAPACITY)
+		n = cacheSize++;
+	else { // evict tail, removing it from its bucket chain
+		n = cacheTail;
+		lruUnlink(n);
+		int *p = &cacheBuckets[keyHash(&cacheNodes[n].entry.key) % CACHE_BUCKETS];
+		while (*p != n)
+			p = &cacheNodes[*p].chain;
+		*p = cacheNodes[n].chain;
+	}
+	cacheNodes[n].entry = *entry;
+	int b = keyHash(&entry->key) % CACHE_BUCKETS;
+	cacheNodes[n].chain = cacheBuckets[b];
+	cacheBuckets[b] = n;
+	lruPushFront(n);
+}
+
+// pointer to record r of the cache file
+static inline CacheEntry *diskRecord(size_t r) {
+	return (CacheEntry *)(cacheMap + 1) + r;
+}
+
+// add record r to the on-disk index (newer records replace older ones with the same key)
+void diskIndexAdd(size_t r) {
+	size_t mask = cacheIndexSize - 1;
+	size_t s = keyHash(&diskRecord(r)->key) & mask;
+	while (cacheIndex[s] != 0 && memcmp(&diskRecord(cacheIndex[s]-1)->key, &diskRecord(r)->key, sizeof(CacheKey)) != 0)
+		s = (s + 1) & mask;
+	cacheIndex[s] = r + 1;
+}
+
+// (re)build the on-disk index over the first given num of records, with room for twice as many
+void diskIndexBuild(size_t records) {
+	size_t r;
+	free(cacheIndex);
+	cacheIndexSize = 1024;
+	while (cacheIndexSize < 2 * records)
+		cacheIndexSize *= 2;
+	cacheIndex = calloc(cacheIndexSize, sizeof(uint32_t));
+	for (r = 0; r < records; r++)
+		diskIndexAdd(r);
+	cacheIndexed = records;
+}
+
+// map the cache file with room for the given num of records, growing the file if needed
+bool diskMap(size_t records) {
+	size_t bytes = sizeof(CacheHeader) + records * sizeof(CacheEntry);
+	struct stat st;
+	if (fstat(cacheFd, &st) != 0)
+		return false;
+	if ((size_t)st.st_size < bytes && ftruncate(cacheFd, bytes) != 0)
+		return false;
+	if (cacheMap)
+		munmap(cacheMap, sizeof(CacheHeader) + cacheMapRecords * sizeof(CacheEntry));
+	cacheMap = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, cacheFd, 0);
+	if (cacheMap == MAP_FAILED) {
+		cacheMap = NULL;
+		return false;
+	}
+	cacheMapRecords = records;
+	return true;
+}
+
+// close the persistent tier, carrying on with the in-memory tier only
+void diskDisable(char *reason) {
+	printf("%s; persistent cache disabled\n", reason);
+	if (cacheMap) {
+		munmap(cacheMap, sizeof(CacheHeader) + cacheMapRecords * sizeof(CacheEntry));
+		cacheMap = NULL;
+	}
+	close(cacheFd);
+	cacheFd = -1;
+}
+
+// index records committed since the last call, by this process or another one sharing the file
+bool diskRefresh() {
+	// a record only counts once the header has been updated, so a torn append is ignored
+	size_t records = __atomic_load_n(&cacheMap->records, __ATOMIC_ACQUIRE);
+	if (records > cacheMapRecords) { // file grown by another process; map the rest of it
+		struct stat st;
+		if (fstat(cacheFd, &st) != 0)
+			return false;
+		size_t fit = (size_t)st.st_size > sizeof(CacheHeader) ? (st.st_size - sizeof(CacheHeader)) / sizeof(CacheEntry) : 0;
+		if (fit > cacheMapRecords && !diskMap(fit))
+			return false;
+		records = MIN(records, cacheMapRecords);
+	}
+	if (2 * records > cacheIndexSize)
+		diskIndexBuild(records);
+	else
+		while (cacheIndexed < records)
+			diskIndexAdd(cacheIndexed++);
+	return true;
+}
+
+// open (or create) the persistent tier; return true if and only if it is usable
+bool diskOpen(char *name) {
+	struct stat st;
+	CacheHeader header;
+	cacheFd = open(name, O_RDWR | O_CREAT, 0644);
+	if (cacheFd < 0) {
+		printf("Problem opening cache file %s\n", name);
+		return false;
+	}
+	// header is written or checked under the lock, so two processes cannot both set up a new file
+	if (flock(cacheFd, LOCK_EX) != 0 || fstat(cacheFd, &st) != 0) {
+		diskDisable("Problem locking cache file");
+		return false;
+	}
+	if (!S_ISREG(st.st_mode)) {
+		diskDisable("Cache file is not a regular file");
+		return false;
+	}
+	if (st.st_size == 0) { // new file; write header
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, CACHE_MAGIC, 8);
+		header.version = CACHE_VERSION;
+		header.recordSize = sizeof(CacheEntry);
+		header.records = 0;
+		if (pwrite(cacheFd, &header, sizeof(header), 0) != sizeof(header)) {
+			diskDisable("Problem writing cache file");
+			return false;
+		}
+		st.st_size = sizeof(header);
+	}
+	// any other file is checked before it is grown or mapped, so a file that is not a cache is left untouched
+	else if ((size_t)st.st_size < sizeof(CacheHeader) || pread(cacheFd, &header, sizeof(header), 0) != sizeof(header)
+		|| memcmp(header.magic, CACHE_MAGIC, 8) != 0 || header.version != CACHE_VERSION || header.recordSize != sizeof(CacheEntry)) {
+		diskDisable("Incorrect cache file syntax");
+		return false;
+	}
+	if (!diskMap((st.st_size - sizeof(CacheHeader)) / sizeof(CacheEntry))) {
+		diskDisable("Problem mapping cache file");
+		return false;
+	}
+	flock(cacheFd, LOCK_UN);
+	diskIndexBuild(0);
+	if (!diskRefresh()) {
+		diskDisable("Problem mapping cache file");
+		return false;
+	}
+	return true;
+}
+
+// look up a key in the persistent tier; return record or NULL
+CacheEntry *diskFind(const CacheKey *key) {
+	if (cacheFd < 0)
+		return NULL;
+	if (!diskRefresh()) {
+		diskDisable("Problem mapping cache file");
+		return NULL;
+	}
+	size_t mask = cacheIndexSize - 1;
+	size_t s = keyHash(key) & mask;
+	while (cacheIndex[s] != 0) {
+		CacheEntry *e = diskRecord(cacheIndex[s]-1);
+		if (memcmp(&e->key, key, sizeof(CacheKey)) == 0)
+			return e;
+		s = (s + 1) & mask;
+	}
+	return NULL;
+}
+
+// append an entry to the persistent tier; processes sharing the file take turns through a lock held per append
+void diskAppend(const CacheEntry *entry) {
+	if (cacheFd < 0)
+		return;
+	if (flock(cacheFd, LOCK_EX) != 0) {
+		diskDisable("Problem locking cache file");
+		return;
+	}
+	if (!diskRefresh()) {
+		diskDisable("Problem mapping cache file");
+		return;
+	}
+	size_t r = cacheIndexed; // all committed records are indexed now
+	if (r == cacheMapRecords && !diskMap(MAX(2 * cacheMapRecords, CACHE_INITIAL_RECORDS))) {
+		diskDisable("Problem growing cache file");
+		return;
+	}
+	*diskRecord(r) = *entry; // write record, then commit it
+	__atomic_store_n(&cacheMap->records, r + 1, __ATOMIC_RELEASE);
+	flock(cacheFd, LOCK_UN);
+	diskRefresh();
+}
+
+// set up the in-memory tier and open the persistent tier if a file was given
+void cacheInit() {
+	int b;
+	for (b = 0; b < CACHE_BUCKETS; b++)
+		cacheBuckets[b] = -1;
+	if (cacheFilename)
+		diskOpen(cacheFilename);
+}
+
+// set up the cache for the current strings x and y
+void cacheOpen() {
+	cacheInit();
+	cacheXHash = hashString(x, xLen);
+	cacheYHash = hashString(y, yLen);
+}
+
+// build a key for the given strings, algorithm and dynamic programming version
+CacheKey makeKey(const char *x, int xLen, const char *y, int yLen, int alg, int variant) {
+	CacheKey key;
+	memset(&key, 0, sizeof(key));
+	key.xHash = hashString(x, xLen);
+	key.yHash = hashString(y, yLen);
+	key.xLen = xLen;
+	key.yLen = yLen;
+	key.alg = alg;
+	key.variant = variant;
+	return key;
+}
+
+// build the key for the current strings and given dynamic programming version
+CacheKey cacheKey(int variant) {
+	CacheKey key;
+	memset(&key, 0, sizeof(key));
+	key.xHash = cacheXHash;
+	key.yHash = cacheYHash;
+	key.xLen = xLen;
+	key.yLen = yLen;
+	key.alg = alg_type;
+	key.variant = variant;
+	return key;
+}
+
+// look up a result by key; return true if and only if found (aux may be NULL)
+bool cacheFetchKey(const CacheKey *key, int *result, int *aux) {
+	CacheEntry entry;
+	int n = lruFind(key);
+	if (n >= 0) {
+		entry = cacheNodes[n].entry;
+		lruUnlink(n);
+		lruPushFront(n);
+		cacheMemHits++;
+	}
+	else {
+		CacheEntry *e = diskFind(key);
+		if (!e) {
+			cacheMisses++;
+			return false;
+		}
+		entry = *e;
+		lruPut(&entry); // promote to in-memory tier
+		cacheDiskHits++;
+	}
+	*result = entry.result;
+	if (aux)
+		*aux = entry.aux;
+	return true;
+}
+
+// look up a result for the current strings; return true if and only if found (aux may be NULL)
+bool cacheFetch(int variant, int *result, int *aux) {
+	CacheKey key = cacheKey(variant);
+	return cacheFetchKey(&key, result, aux);
+}
+
+// store a result by key in both tiers
+void cacheSaveKey(const CacheKey *key, int result, int aux) {
+	CacheEntry entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.key = *key;
+	entry.result = result;
+	entry.aux = aux;
+	lruPut(&entry);
+	diskAppend(&entry);
+}
+
+// store a result for the current strings in both tiers
+void cacheSave(int variant, int result, int aux) {
+	CacheKey key = cacheKey(variant);
+	cacheSaveKey(&key, result, aux);
+}
+
+// print hit/miss ratios and release the persistent tier
+void cacheClose() {
+	long lookups = cacheMemHits + cacheDiskHits + cacheMisses;
+	if (lookups > 0)
+		printf("\nCache hits: %ld (memory %ld, disk %ld), misses: %ld, hit ratio: %.1f%%\n",
+			cacheMemHits + cacheDiskHits, cacheMemHits, cacheDiskHits, cacheMisses,
+			100.0 * (cacheMemHits + cacheDiskHits) / lookups);
+	if (cacheMap) {
+		munmap(cacheMap, sizeof(CacheHeader) + cacheMapRecords * sizeof(CacheEntry));
+		cacheMap = NULL;
+	}
+	if (cacheFd >= 0) {
+		close(cacheFd);
+		cacheFd = -1;
+	}
+	free(cacheIndex);
+	cacheIndex = NULL;
+}
+
+/**************************** WORKER DAEMON ********************************/
+/** serves requests over a Unix domain socket from a persistent pool of threads. **/
+/** every request and response is a frame: a 4-byte length (network byte order) then a payload. **/
+/** request payload: 1 byte op (0 LCS, 1 ED, 2 SW, 3 stats), then for ops 0-2 either **/
+/**   1 byte 0, 4-byte xLen, x, 4-byte yLen, y   (strings given inline) or **/
+/**   1 byte 1, file path                        (strings read from file, as with -f) **/
+/** response payload: text, "OK <result>", "ERR <reason>" or the stats line. **/
+/** the listening thread receives requests without blocking and queues each complete one **/
+/** for the thread pool, so idle or slow clients never hold a thread; a client that stalls **/
+/** mid-request is dropped after a timeout **/
+
+#define DAEMON_QUEUE 256 // max num of requests waiting for a thread
+#define DAEMON_MAX_FRAME (1 << 24) // largest request (and largest file) accepted
+#define DAEMON_ARENA 65536 // initial num of ints per DP row in each arena
+#define DAEMON_ARENA_KEEP (1 << 22) // arena and payload buffers larger than this many bytes are shrunk after each request
+#define LATENCY_SAMPLES 65536 // num of most recent latencies kept for percentiles
+#define DAEMON_TIMEOUT 5 // seconds a client may take to send the rest of a request or read a response
+
+enum {OP_LCS, OP_ED, OP_SW, OP_STATS}; // request ops
+
+typedef struct arena { // per-thread memory reused across requests
+	int *rows; // two DP rows
+	size_t rowCap; // num of ints each row has room for
+	char *buf; // file contents
+	size_t bufCap; // size of buf
+} Arena;
+
+typedef struct connection { // client connection; owned by the listening thread while a request
+                            // arrives and by a worker while the request is served
+	int fd;
+	unsigned char header[4]; // length prefix of request being received
+	size_t got; // num of bytes of header and payload received so far
+	uint32_t len; // payload length (once header received)
+	char *payload; // request payload
+	size_t cap; // size of payload buffer
+	const char *reject; // error to answer instead of serving the request (NULL if none)
+	long lastActive; // when bytes were last received, in microseconds
+	long received; // when the whole request was in, in microseconds; latency is measured from here
+} Connection;
+
+Connection *daemonQueue[DAEMON_QUEUE]; // complete requests waiting for a thread
+int queueHead = 0, queueLen = 0; // first waiting request and num waiting
+pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t queueNotEmpty = PTHREAD_COND_INITIALIZER;
+pthread_cond_t queueNotFull = PTHREAD_COND_INITIALIZER;
+int wakePipe[2]; // workers hand connections back to the listening thread through this
+
+pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER; // the result cache is shared by all threads
+
+long latencies[LATENCY_SAMPLES]; // ring of most recent request latencies in microseconds
+long requestsServed = 0, requestsFailed = 0; // num of requests answered OK and with ERR
+pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+
+// write exactly len bytes; return true if and only if successful
+bool writeFull(int fd, const void *buf, size_t len) {
+	const char *p = buf;
+	while (len > 0) {
+		ssize_t r = write(fd, p, len);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0)
+			return false;
+		p += r;
+		len -= r;
+	}
+	return true;
+}
+
+// send a text response frame
+bool sendFrame(int fd, const char *text) {
+	uint32_t len = htonl(strlen(text));
+	return writeFull(fd, &len, 4) && writeFull(fd, text, strlen(text));
+}
+
+// make sure arena buffer has room for len bytes; return true if and only if successful
+bool arenaReserve(Arena *a, size_t len) {
+	if (len > a->bufCap) {
+		size_t cap = MAX(len, 2 * a->bufCap);
+		char *buf = realloc(a->buf, cap);
+		if (!buf)
+			return false;
+		a->buf = buf;
+		a->bufCap = cap;
+	}
+	return true;
+}
+
+// shrink arena back to its initial size after a request that needed a lot more
+void arenaTrim(Arena *a) {
+	if (a->bufCap > DAEMON_ARENA_KEEP) {
+		char *buf = realloc(a->buf, 2 * DAEMON_ARENA);
+		if (buf) {
+			a->buf = buf;
+			a->bufCap = 2 * DAEMON_ARENA;
+		}
+	}
+	if (2 * a->rowCap * sizeof(int) > DAEMON_ARENA_KEEP) {
+		int *rows = realloc(a->rows, 2 * DAEMON_ARENA * sizeof(int));
+		if (rows) {
+			a->rows = rows;
+			a->rowCap = DAEMON_ARENA;
+		}
+	}
+}
+
+// score of the given algorithm, computed row by row in the arena with the row steps of lcs, ed, hsls;
+// returns -1 if the rows cannot be allocated
+int arenaScore(Arena *a, int alg, const char *x, int m, const char *y, int n) {
+	if ((size_t)n + 1 > a->rowCap) {
+		size_t cap = MAX((size_t)n + 1, 2 * a->rowCap);
+		int *rows = realloc(a->rows, 2 * cap * sizeof(int));
+		if (!rows)
+			return -1;
+		a->rows = rows;
+		a->rowCap = cap;
+	}
+	int *prev = a->rows, *cur = a->rows + a->rowCap, *tmp;
+	int i, j, bestScore = 0;
+	for (j = 0; j <= n; j++)
+		prev[j] = alg == ED ? j : 0;
+	for (i = 1; i <= m; i++) {
+		cur[0] = alg == ED ? i : 0;
+		if (alg == LCS)
+			lcsStep(prev, cur, x[i-1], y, n);
+		else if (alg == ED)
+			edStep(prev, cur, x[i-1], y, n);
+		else
+			bestScore = MAX(bestScore, swStep(prev, cur, x[i-1], y, n));
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+	return alg == SW ? bestScore : prev[n];
+}
+
+// read strings from file into the arena, by the same rules as readStrings; return error or NULL
+const char *arenaReadFile(Arena *a, const char *name, char **x, int *xLen, char **y, int *yLen) {
+	struct stat st;
+	FILE *file = fopen(name, "rb");
+	if (!file)
+		return "problem opening file";
+	const char *error = NULL;
+	if (fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode))
+		error = "not a regular file";
+	else if (st.st_size > DAEMON_MAX_FRAME)
+		error = "file too large";
+	else if (!arenaReserve(a, st.st_size))
+		error = "out of memory";
+	size_t got = error ? 0 : fread(a->buf, 1, st.st_size, file);
+	fclose(file);
+	if (error)
+		return error;
+
+	// x ends at the first '\n' or '\r', which must be present; if it was '\r' the next char is skipped too
+	char *p = a->buf, *end = a->buf + got;
+	while (p < end && *p != '\n' && *p != '\r')
+		p++;
+	if (p == end)
+		return "incorrect file syntax";
+	*x = a->buf;
+	*xLen = p - a->buf;
+	p = MIN(p + (*p == '\r' ? 2 : 1), end);
+	// y ends at the next '\n', '\r' or end of file
+	*y = p;
+	while (p < end && *p != '\n' && *p != '\r')
+		p++;
+	*yLen = p - *y;
+	if (*xLen == 0 || *yLen == 0)
+		return "incorrect file syntax";
+	return NULL;
+}
+
+// compare longs for qsort
+int compareLongs(const void *p, const void *q) {
+	long a = *(const long *)p, b = *(const long *)q;
+	return (a > b) - (a < b);
+}
+
+// write stats line (request counts, p50/p99 latency, cache hit/miss counts) into out
+void daemonStats(char *out, size_t size) {
+	static long sorted[LATENCY_SAMPLES];
+	pthread_mutex_lock(&statsLock);
+	long n = MIN(requestsServed + requestsFailed, LATENCY_SAMPLES);
+	memcpy(sorted, latencies, n * sizeof(long));
+	long served = requestsServed, failed = requestsFailed;
+	qsort(sorted, n, sizeof(long), compareLongs);
+	long p50 = n ? sorted[(n-1) * 50 / 100] : 0, p99 = n ? sorted[(n-1) * 99 / 100] : 0;
+	pthread_mutex_unlock(&statsLock);
+	pthread_mutex_lock(&cacheLock);
+	snprintf(out, size, "requests %ld errors %ld p50_us %ld p99_us %ld cache_hits %ld cache_misses %ld",
+		served, failed, p50, p99, cacheMemHits + cacheDiskHits, cacheMisses);
+	pthread_mutex_unlock(&cacheLock);
+}
+
+// answer one request payload of length len; writes response text into out
+void daemonRequest(Arena *a, const unsigned char *p, size_t len, char *out, size_t size) {
+	char *x, *y;
+	int xLen, yLen;
+	uint32_t l;
+	const char *error = NULL;
+	if (len >= 1 && p[0] == OP_STATS) {
+		daemonStats(out, size);
+		return;
+	}
+	int alg = len < 1 ? NONE : p[0] == OP_LCS ? LCS : p[0] == OP_ED ? ED : SW;
+	if (len < 2 || p[0] > OP_SW)
+		error = "unknown request";
+	else if (p[1] == 0) { // strings inline
+		size_t off = 2;
+		l = 0;
+		if (len >= off + 4) {
+			memcpy(&l, p + off, 4);
+			l = ntohl(l);
+		}
+		if (len < off + 4 + (size_t)l + 4)
+			error = "truncated request";
+		else {
+			x = (char *)p + off + 4;
+			xLen = l;
+			off += 4 + l;
+			memcpy(&l, p + off, 4);
+			l = ntohl(l);
+			y = (char *)p + off + 4;
+			yLen = l;
+			if (len != off + 4 + (size_t)l)
+				error = "truncated request";
+			else if (xLen <= 0 || yLen <= 0)
+				error = "empty string";
+		}
+	}
+	else if (p[1] == 1) { // strings from file; path copied out to terminate it
+		if (len - 2 >= PATH_MAX)
+			error = "path too long";
+		else {
+			char path[PATH_MAX];
+			memcpy(path, p + 2, len - 2);
+			path[len - 2] = '\0';
+			error = arenaReadFile(a, path, &x, &xLen, &y, &yLen);
+		}
+	}
+	else
+		error = "unknown string source";
+	if (error) {
+		snprintf(out, size, "ERR %s", error);
+		return;
+	}
+
+	int result;
+	bool cached = false;
+	CacheKey key;
+	if (cacheBool) {
+		key = makeKey(x, xLen, y, yLen, alg, ITERATIVE);
+		pthread_mutex_lock(&cacheLock);
+		cached = cacheFetchKey(&key, &result, NULL);
+		pthread_mutex_unlock(&cacheLock);
+	}
+	if (!cached) {
+		result = arenaScore(a, alg, x, xLen, y, yLen);
+		if (result < 0) {
+			snprintf(out, size, "ERR out of memory");
+			return;
+		}
+		if (cacheBool) {
+			pthread_mutex_lock(&cacheLock);
+			cacheSaveKey(&key, result, 0);
+			pthread_mutex_unlock(&cacheLock);
+		}
+	}
+	snprintf(out, size, "OK %d", result);
+}
+
+// microseconds on the monotonic clock
+long nowMicros() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+// make a connection ready for its next request, shrinking its payload buffer if a request needed a lot
+void connReset(Connection *c) {
+	c->got = 0;
+	c->len = 0;
+	c->reject = NULL;
+	if (c->cap > DAEMON_ARENA_KEEP) {
+		free(c->payload);
+		c->payload = NULL;
+		c->cap = 0;
+	}
+}
+
+// close a connection and free its memory
+void connClose(Connection *c) {
+	close(c->fd);
+	free(c->payload);
+	free(c);
+}
+
+// receive whatever has arrived on a connection without blocking;
+// return 1 if a whole request is in, 0 if more is due, -1 if the connection was closed
+int connReceive(Connection *c, long now) {
+	while (c->got < 4 || c->got - 4 < c->len) {
+		ssize_t r;
+		if (c->got < 4)
+			r = recv(c->fd, c->header + c->got, 4 - c->got, MSG_DONTWAIT);
+		else
+			r = recv(c->fd, c->payload + (c->got - 4), c->len - (c->got - 4), MSG_DONTWAIT);
+		if (r == 0)
+			return -1;
+		if (r < 0)
+			return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+		c->got += r;
+		c->lastActive = now;
+		if (c->got == 4) { // header complete; make room for payload
+			uint32_t len;
+			memcpy(&len, c->header, 4);
+			c->len = ntohl(len);
+			if (c->len > DAEMON_MAX_FRAME) {
+				c->reject = "frame too large";
+				return 1;
+			}
+			if (c->len > c->cap) {
+				char *payload = realloc(c->payload, c->len);
+				if (!payload) {
+					c->reject = "out of memory";
+					return 1;
+				}
+				c->payload = payload;
+				c->cap = c->len;
+			}
+		}
+	}
+	return 1;
+}
+
+// serve the request received on a connection; return true if and only if the connection stays open
+bool daemonServe(Arena *a, Connection *c) {
+	char out[256];
+	if (c->reject) { // the rest of the request cannot be read, so the connection is closed
+		snprintf(out, sizeof(out), "ERR %s", c->reject);
+		sendFrame(c->fd, out);
+		return false;
+	}
+	int op = c->len < 1 ? -1 : (unsigned char)c->payload[0];
+	daemonRequest(a, (unsigned char *)c->payload, c->len, out, sizeof(out));
+	arenaTrim(a);
+	bool sent = sendFrame(c->fd, out);
+	// latency as the caller sees it: waiting in the queue, serving and sending the response
+	if (op != OP_STATS) { // stats requests are not counted
+		long latency = nowMicros() - c->received;
+		pthread_mutex_lock(&statsLock);
+		latencies[(requestsServed + requestsFailed) % LATENCY_SAMPLES] = latency;
+		if (strncmp(out, "OK", 2) == 0)
+			requestsServed++;
+		else
+			requestsFailed++;
+		pthread_mutex_unlock(&statsLock);
+	}
+	connReset(c);
+	return sent;
+}
+
+// thread body: take requests from the queue and serve them, reusing one arena
+void *daemonWorker(void *arg) {
+	Arena a;
+	a.rowCap = DAEMON_ARENA;
+	a.rows = malloc(2 * a.rowCap * sizeof(int));
+	a.bufCap = 2 * DAEMON_ARENA;
+	a.buf = malloc(a.bufCap);
+	while (true) {
+		pthread_mutex_lock(&queueLock);
+		while (queueLen == 0)
+			pthread_cond_wait(&queueNotEmpty, &queueLock);
+		Connection *c = daemonQueue[queueHead];
+		queueHead = (queueHead + 1) % DAEMON_QUEUE;
+		queueLen--;
+		pthread_cond_signal(&queueNotFull);
+		pthread_mutex_unlock(&queueLock);
+		// connection goes back to the listening thread to receive its next request
+		if (!daemonServe(&a, c) || !writeFull(wakePipe[1], &c, sizeof(c)))
+			connClose(c);
+	}
+	return NULL;
+}
+
+// hand a complete request to the thread pool
+void daemonQueuePush(Connection *c) {
+	pthread_mutex_lock(&queueLock);
+	while (queueLen == DAEMON_QUEUE)
+		pthread_cond_wait(&queueNotFull, &queueLock);
+	daemonQueue[(queueHead + queueLen) % DAEMON_QUEUE] = c;
+	queueLen++;
+	pthread_cond_signal(&queueNotEmpty);
+	pthread_mutex_unlock(&queueLock);
+}
+
+struct pollfd *pollFds; // poll set: listening socket, pipe from workers, then connections receiving
+Connection **pollConns; // connection of each entry in poll set (NULL for first two)
+int pollLen = 0, pollCap = 0; // num of entries in poll set and room for them
+
+// add an entry to the poll set, growing it if needed; return false if out of memory
+bool pollAdd(int fd, Connection *c) {
+	if (pollLen == pollCap) {
+		int cap = MAX(64, 2 * pollCap);
+		struct pollfd *fds = realloc(pollFds, cap * sizeof(struct pollfd));
+		if (fds)
+			pollFds = fds;
+		Connection **conns = realloc(pollConns, cap * sizeof(Connection *));
+		if (conns)
+			pollConns = conns;
+		if (!fds || !conns)
+			return false;
+		pollCap = cap;
+	}
+	pollFds[pollLen].fd = fd;
+	pollFds[pollLen].events = POLLIN;
+	pollFds[pollLen].revents = 0;
+	pollConns[pollLen] = c;
+	pollLen++;
+	return true;
+}
+
+// remove entry k from the poll set, moving the last entry into its place
+void pollRemove(int k) {
+	pollLen--;
+	pollFds[k] = pollFds[pollLen];
+	pollConns[k] = pollConns[pollLen];
+}
+
+// remove socket file and exit on SIGINT/SIGTERM
+void daemonStop(int sig) {
+	unlink(socketFilename);
+	_exit(0);
+}
+
+// listen on the socket and hand connections to the thread pool; return only on failure
+void runDaemon() {
+	struct sockaddr_un addr;
+	int t, fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(socketFilename) >= sizeof(addr.sun_path)) {
+		printf("Socket path %s too long\n", socketFilename);
+		return;
+	}
+	strcpy(addr.sun_path, socketFilename);
+	unlink(socketFilename); // left over from an earlier run
+	if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, DAEMON_QUEUE) != 0) {
+		printf("Problem listening on socket %s\n", socketFilename);
+		return;
+	}
+	signal(SIGPIPE, SIG_IGN); // clients may hang up before reading a response
+	signal(SIGINT, daemonStop);
+	signal(SIGTERM, daemonStop);
+	if (cacheBool)
+		cacheInit();
+	if (daemonThreads <= 0)
+		daemonThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (pipe(wakePipe) != 0) {
+		printf("Problem creating pipe\n");
+		return;
+	}
+	int started = 0;
+	for (t = 0; t < daemonThreads; t++) {
+		pthread_t tid;
+		if (pthread_create(&tid, NULL, daemonWorker, NULL) == 0) {
+			pthread_detach(tid);
+			started++;
+		}
+	}
+	if (started == 0) {
+		printf("Problem starting threads\n");
+		return;
+	}
+	printf("Listening on %s with %d threads\n", socketFilename, started);
+	fflush(stdout);
+
+	if (!pollAdd(fd, NULL) || !pollAdd(wakePipe[0], NULL)) {
+		printf("Problem allocating poll set\n");
+		return;
+	}
+	struct timeval timeout = {DAEMON_TIMEOUT, 0};
+	while (true) {
+		if (poll(pollFds, pollLen, 1000) < 0) // wakes every second to drop stalled clients
+			continue; // interrupted
+		long now = nowMicros();
+		int k;
+		// receive on connections; whole requests go to the thread pool
+		for (k = pollLen-1; k >= 2; k--) { // entries moved by pollRemove have been visited already
+			Connection *c = pollConns[k];
+			int state = 0;
+			if (pollFds[k].revents)
+				state = connReceive(c, now);
+			if (state == 0 && c->got > 0 && now - c->lastActive > DAEMON_TIMEOUT * 1000000L)
+				state = -1; // stalled mid-request
+			if (state != 0) {
+				pollRemove(k);
+				if (state > 0) {
+					c->received = nowMicros();
+					daemonQueuePush(c);
+				}
+				else
+					connClose(c);
+			}
+		}
+		// connections handed back by workers (writes of single pointers to a pipe are atomic)
+		if (pollFds[1].revents & POLLIN) {
+			Connection *back[64];
+			ssize_t r = read(wakePipe[0], back, sizeof(back));
+			for (k = 0; k < r / (ssize_t)sizeof(Connection *); k++)
+				if (!pollAdd(back[k]->fd, back[k]))
+					connClose(back[k]);
+		}
+		// new connection
+		if (pollFds[0].revents & POLLIN) {
+			int client = accept(fd, NULL, NULL);
+			if (client < 0) {
+				if (errno == EMFILE || errno == ENFILE) { // out of descriptors; back off rather than spin
+					struct timespec pause = {0, 10000000};
+					nanosleep(&pause, NULL);
+				}
+				continue;
+			}
+			// receives never block; sends by workers give up on clients that stop reading
+			setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+			Connection *c = calloc(1, sizeof(Connection));
+			if (c)
+				c->fd = client;
+			if (!c || !pollAdd(client, c)) {
+				free(c);
+				close(client);
+			}
+		}
+	}
+}
+
 // main method, entry point
 int main(int argc, char *argv[]) {
 	clock_t begin, end;
@@ -666,46 +2355,111 @@ int main(int argc, char *argv[]) {
 	bool isIllegal = getArgs(argc, argv); // parse arguments from command line
 	if (isIllegal) // print error and quit if illegal arguments
 		printf("Illegal arguments\n");
+	else if (daemonBool) // serve requests until stopped
+		runDaemon();
+	else if (viewBool) // render window of a dump file
+		renderDump(viewFilename, viewWindow[0], viewWindow[1], viewWindow[2], viewWindow[3]);
 	else {
 		printf("%s\n", alg_desc); // confirm algorithm to be executed
 		bool success = true;
-		if (genStringsBool)
+		if (genStringsBool) {
+			if (!seedBool)
+				seed = time(NULL); // seeded based on current time
+			printf("Seed: %llu\n", (unsigned long long)seed); // so the strings can be generated again
 			generateStrings(); // generate two random strings
+			if (writeBool)
+				success = writeStrings();
+		}
 		else
 			success = readStrings(); // else read strings from file
 		if (success) { // do not proceed if file input was problematic
+			// the cache only holds results, so it is bypassed when the table is printed or dumped
+			bool useCache = cacheBool && !printBool && !dumpBool;
+			if (useCache)
+				cacheOpen();
 			// confirm dynamic programming type
 			// these print commamds are just placeholders for now
 			if (iterBool) {
 				printf("Iterative version\n");
 
-				// start clock
-				begin = clock();
+				// look up result, skipping the computation on a hit
+				bool cached = useCache && cacheFetch(ITERATIVE, &result, NULL);
+				begin = end = clock();
+				if (!cached) {
+					// start clock
+					begin = clock();
+
+					// choose alg
+					if (alg_type==LCS && outOfCoreBool)
+						result = oocLcs(xLen, yLen);
+					else if (alg_type==LCS)
+						result = lcs(x,y);
+					else if (alg_type==ED)
+						result = ed(x,y);
+					else if (alg_type==SW)
+						result = hsls(x,y);
+
+					// end clock
+					end = clock();
+
+					if (useCache && result >= 0)
+						cacheSave(ITERATIVE, result, 0);
+				}
 
-				// choose alg
-				if (alg_type==LCS)
-					result = lcs(x,y);
-				else if (alg_type==ED)
-					result = ed(x,y);
-				else if (alg_type==SW)
-					result = hsls(x,y);
+				if (result < 0) // out-of-core set-up failed; message already printed
+					printf("Iterative version not run\n");
+				else {
+					// print result
+					printf("%s %d\n", result_string, result);
+
+					if (printBool && outOfCoreBool) // table is not held in memory; print alignment only
+						oocAlign(xLen, yLen, result);
+					else if (printBool) {
+						// print dynamic programming table
+						printf("Dynamic programming table:\n");
+						printTable(xLen, yLen);
+						if (alg_type==LCS)
+							ilcsAlign(xLen, yLen);
+					}
+					if (dumpBool)
+						dumpTable(xLen, yLen, "iter");
+
+					// destroy table
+					if (cached)
+						printf("Result taken from cache\n");
+					else if (outOfCoreBool)
+						destroyCheckpoints();
+					else
+						destroyTable(xLen, yLen);
+				}
 
-				// end clock
-				end = clock();
+				// print time
+				time_spent = (double)(end - begin) / CLOCKS_PER_SEC;
+				printf("\nTime taken: %0.2f seconds\n", time_spent);
+			}
+			if (diagBool) {
+				printf("Diagonal-transition version\n");
 
-				// print result
-				printf("%s %d\n", result_string, result);
+				// same result as iterative version, so shares its cache entries
+				bool cached = useCache && cacheFetch(ITERATIVE, &result, NULL);
+				begin = end = clock();
+				if (!cached) {
+					// start clock
+					begin = clock();
 
-				if (printBool) {
-					// print dynamic programming table
-					printf("Dynamic programming table:\n");
-					printTable(xLen, yLen);
-					if (alg_type==LCS)
-						ilcsAlign(xLen, yLen);
+					result = dted(x,y);
+
+					// end clock
+					end = clock();
+
+					if (useCache)
+						cacheSave(ITERATIVE, result, 0);
 				}
 
-				// destroy table
-				destroyTable(xLen, yLen);
+				// print result
+				printf("%s %d\n", result_string, result);
+				if (cached)
+					printf("Result taken from cache\n");
 
 				// print time
 				time_spent = (double)(end - begin) / CLOCKS_PER_SEC;
@@ -714,17 +2468,25 @@ int main(int argc, char *argv[]) {
 			if (recMemoBool && (alg_type==LCS || alg_type==ED)) {
 				printf("Recursive version with memoisation\n");
 
-				// start clock
-				begin = clock();
+				// look up result and entries computed, skipping the computation on a hit
+				bool cached = useCache && cacheFetch(MEMOISED, &result, &count);
+				begin = end = clock();
+				if (!cached) {
+					// start clock
+					begin = clock();
 
-				// choose alg
-				if (alg_type==LCS)
-					result = mlcs(xLen, yLen);
-				else if (alg_type==ED)
-					result = med(xLen, yLen);
+					// choose alg
+					if (alg_type==LCS)
+						result = mlcs(xLen, yLen);
+					else if (alg_type==ED)
+						result = med(xLen, yLen);
+
+					// end clock
+					end = clock();
 
-				// end clock
-				end = clock();
+					if (useCache)
+						cacheSave(MEMOISED, result, count);
+				}
 
 				if (printBool) {
 					// print dynamic programming table
@@ -734,6 +2496,8 @@ int main(int argc, char *argv[]) {
 						mlcsAlign(xLen, yLen);
 
 				}
+				if (dumpBool)
+					dumpPairsTable(xLen, yLen);
 
 				// print result
 				printf("%s %d\n", result_string, result);
@@ -746,10 +2510,14 @@ int main(int argc, char *argv[]) {
 				calc = ((float)count/(float)tsize)*100.0;
 				printf("Proportion of table computed: %.1f%%\n", calc);
 
-				// destroy table
-				destroyPairsTable(xLen, yLen);
-				// destroy helper array
-				destroyHelperArray();
+				if (cached)
+					printf("Result taken from cache\n");
+				else {
+					// destroy table
+					destroyPairsTable(xLen, yLen);
+					// destroy helper array
+					destroyHelperArray();
+				}
 
 				// print time
 				time_spent = (double)(end - begin) / CLOCKS_PER_SEC;
@@ -758,26 +2526,39 @@ int main(int argc, char *argv[]) {
 			if (recNoMemoBool && (alg_type==LCS || alg_type==ED)) {
 				printf("Recursive version without memoisation\n");
 
-				// start clock
-				begin = clock();
+				// look up result, skipping the computation on a hit
+				bool cached = useCache && cacheFetch(RECURSIVE, &result, NULL);
+				begin = end = clock();
+				if (!cached) {
+					// start clock
+					begin = clock();
+
+					// choose alg
+					if (alg_type==LCS)
+						result = rlcs(xLen, yLen);
+					else if (alg_type==ED)
+						result = red(xLen, yLen);
 
-				// choose alg
-				if (alg_type==LCS)
-					result = rlcs(xLen, yLen);
-				else if (alg_type==ED)
-					result = red(xLen, yLen);
+					// end clock
+					end = clock();
 
-				// end clock
-				end = clock();
+					if (useCache)
+						cacheSave(RECURSIVE, result, 0);
+				}
 
 				if (printBool) {
 					// print dynamic programming table
 					printf("Dynamic programming table:\n");
 					printTable(xLen, yLen);
 				}
+				if (dumpBool)
+					dumpTable(xLen, yLen, "rec");
 
 				// destroy table
-				destroyTable(xLen, yLen);
+				if (cached)
+					printf("Result taken from cache\n");
+				else
+					destroyTable(xLen, yLen);
 
 				// print result
 				printf("\nTotal number of times a table entry computed: %d\n", result);
@@ -786,6 +2567,8 @@ int main(int argc, char *argv[]) {
 				time_spent = (double)(end - begin) / CLOCKS_PER_SEC;
 				printf("Time taken: %0.2f seconds\n", time_spent);
 			}
+			if (useCache)
+				cacheClose(); // report hit/miss ratios
 			freeMemory(); // free memory occupied by strings
 		}
 	}